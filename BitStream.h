@@ -0,0 +1,123 @@
+#ifndef BITSTREAM_H
+#define BITSTREAM_H
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+/*
+ * BitWriter appends fields of 1 to 64 bits to a buffer of uint64_t
+ * words, and BitReader reads them back in the same order.  Fields are
+ * packed from the low order bit up with no padding, so a field may
+ * straddle two words: the first field goes in bits 0 through width - 1
+ * of word 0, exactly where copyBits(value, 0, 0, 0, width) would put it.
+ *
+ * The writer collects bits in a 64-bit accumulator and moves on to the
+ * next word each time the accumulator fills.  reset() empties the writer but
+ * keeps its buffer, so once the buffer has grown to fit the largest
+ * stream, encoding more streams allocates nothing.  The array forms of
+ * put keep the accumulator in registers for the whole array and are the
+ * fast path for bulk encoding.
+ */
+class BitWriter
+{
+   private:
+      std::vector<uint64_t> words;
+      size_t wordsUsed;
+      uint64_t acc;
+      int32_t accBits;
+
+      void grow();
+
+   public:
+      BitWriter();
+      explicit BitWriter(size_t bits);
+
+      bool put(uint64_t value, int32_t width);
+      bool put(const uint64_t * values, const int32_t * widths, size_t count);
+      bool put(const uint64_t * values, size_t count, int32_t width);
+      size_t finish();
+      void reset();
+      void reserve(size_t bits);
+
+      size_t size() const { return wordsUsed * 64 + accBits; }
+      size_t capacity() const { return words.size() * 64; }
+      const uint64_t * data() const { return words.data(); }
+};
+
+class BitReader
+{
+   private:
+      const uint64_t * words;
+      size_t bits;
+      size_t pos;
+
+   public:
+      BitReader(const uint64_t * words, size_t bits);
+
+      uint64_t get(int32_t width);
+      void seek(size_t bit) { pos = bit < bits ? bit : bits; }
+      size_t position() const { return pos; }
+      size_t remaining() const { return bits - pos; }
+};
+
+/**
+ * appends the low width bits of value to the stream; the other bits of
+ * value are ignored. returns false, and appends nothing, if width is
+ * not 1 through 64.
+ *
+ * for example, put(0x5, 3) then put(0x1ff, 9) leaves the low 12 bits
+ *              of the first word as 0xffd
+ *
+ * @param uint64_t value that holds the field in its low order bits
+ * @param int32_t width that is the number of bits in the field
+ * @return true if the field was appended
+ */
+inline bool BitWriter::put(uint64_t value, int32_t width)
+{
+   if (width < 1 || width > 64) {
+      return false;
+   }
+
+   //the accumulator is stored every time and the word count only moves
+   //when it fills, so there is no hard to predict branch; the buffer
+   //always has a spare word for the store
+   value &= 0xffffffffffffffff >> (64 - width);
+   uint64_t full = acc | (value << accBits);
+   uint64_t spill = (value >> 1) >> (63 - accBits);
+   int32_t total = accBits + width;
+   words[wordsUsed] = full;
+   wordsUsed += total >> 6;
+   acc = total >= 64 ? spill : full;
+   accBits = total & 63;
+   if (wordsUsed == words.size()) {
+      grow();
+   }
+   return true;
+}
+
+/**
+ * returns the next width bits of the stream and moves past them.
+ * returns 0, and does not move, if width is not 1 through 64 or fewer
+ * than width bits are left.
+ *
+ * @param int32_t width that is the number of bits in the field
+ * @return the field in the low order bits
+ */
+inline uint64_t BitReader::get(int32_t width)
+{
+   if (width < 1 || width > 64 || (size_t) width > bits - pos) {
+      return 0;
+   }
+
+   size_t w = pos / 64;
+   int32_t shift = pos % 64;
+   uint64_t value = words[w] >> shift;
+   if (shift + width > 64) {
+      value |= words[w + 1] << (64 - shift);
+   }
+   pos += width;
+   return value & (0xffffffffffffffff >> (64 - width));
+}
+
+#endif
@@ -0,0 +1,89 @@
+#ifndef BITVECTOR_H
+#define BITVECTOR_H
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+/*
+ * BitVector is an arbitrary length array of bits stored in uint64_t
+ * words.  Bit 0 is the low order bit of word 0.  The range operations
+ * take the same (low, high) bit numbers as the Tools functions but the
+ * range may cross word boundaries and run to the end of the vector;
+ * like the Tools functions, an out of range request leaves the vector
+ * unchanged (or returns 0).
+ *
+ * buildIndex adds a rank/select index: a 64-bit count of ones before
+ * every 2048-bit superblock, a 16-bit count relative to the superblock
+ * before every 256-bit block and a sample of the superblock holding
+ * every 4096th one.  When the 4096 ones from one sample to the next
+ * are spread over more than SPARSESUPERS superblocks, their positions
+ * are also stored outright.  The index costs under 10% of the bit
+ * storage, plus at most 6.25% of the bits in such sparse stretches.
+ * rank1 is then a table lookup plus at most 4 popcounts, and select1
+ * is either a lookup in the stored positions or a binary search of at
+ * most 11 steps over SPARSESUPERS superblocks, then at most 8 blocks
+ * and 4 words, so neither depends on the size of the vector.  Any
+ * change to the bits drops the index; rank1 and select1 still work
+ * without it by scanning.
+ */
+class BitVector
+{
+   private:
+      std::vector<uint64_t> words;
+      size_t bits;
+
+      std::vector<uint64_t> superRanks;
+      std::vector<uint16_t> blockRanks;
+      std::vector<uint32_t> selectSamples;
+      std::vector<uint32_t> sparseGroups;   //1 + group number in sparseOnes, or 0
+      std::vector<uint64_t> sparseOnes;
+      bool indexed;
+
+      void putBits(size_t low, int32_t length, uint64_t value);
+      void clearTail();
+      void dropIndex();
+
+   public:
+      static const size_t WORDBITS = 64;
+      static const size_t BLOCKBITS = 256;
+      static const size_t SUPERBITS = 2048;
+      static const size_t SELECTSAMPLE = 4096;
+      static const size_t SPARSESUPERS = 2048;
+
+      BitVector();
+      explicit BitVector(size_t bits);
+
+      size_t size() const { return bits; }
+      size_t wordCount() const { return words.size(); }
+      const uint64_t * data() const { return words.data(); }
+      void resize(size_t bits);
+
+      bool get(size_t bit) const;
+      void set(size_t bit);
+      void clear(size_t bit);
+
+      uint64_t getBits(size_t low, size_t high) const;
+      void setBits(size_t low, size_t high);
+      void clearBits(size_t low, size_t high);
+      void copyBits(const BitVector & source, size_t srclow, size_t dstlow,
+                    size_t length);
+
+      void setAll();
+      void clearAll();
+      void invert();
+      BitVector & operator&=(const BitVector & other);
+      BitVector & operator|=(const BitVector & other);
+      BitVector & operator^=(const BitVector & other);
+      bool operator==(const BitVector & other) const;
+      size_t count() const;
+
+      void buildIndex();
+      bool hasIndex() const { return indexed; }
+      size_t indexBytes() const;
+      size_t rank1(size_t bit) const;
+      size_t rank0(size_t bit) const { return bit - rank1(bit); }
+      size_t select1(size_t k) const;
+};
+
+#endif
@@ -0,0 +1,51 @@
+#ifndef FIELDLAYOUT_H
+#define FIELDLAYOUT_H
+
+#include <cstdint>
+#include <cstddef>
+
+/*
+ * FieldLayout describes a record packed into one uint64_t as a list of
+ * (low, high) bit ranges, the same ranges getBits and copyBits take.
+ * The shifts and masks for every field are worked out once when the
+ * field is added; extract then pulls every field out of a word and
+ * pack puts every field into a word in one pass.
+ *
+ * extract is a shift and a mask per field on the record itself.  When
+ * the fields do not overlap and the CPU has a fast pdep, pack builds
+ * the fields into one compact word and scatters it into the record
+ * with a single pdep instead of clearing and setting each field in
+ * turn.  Both ways give the same results as calling getBits or copyBits
+ * once per field.
+ */
+class FieldLayout
+{
+   public:
+      static const int32_t MAXFIELDS = 16;
+
+   private:
+      int32_t fieldCount;
+      int32_t lows[MAXFIELDS];
+      uint64_t masks[MAXFIELDS];     //field mask, in the low order bits
+      int32_t offsets[MAXFIELDS];    //field position in the compact word
+      uint64_t layoutMask;           //every bit that belongs to a field
+      bool overlapping;
+      bool bmi2;
+
+   public:
+      FieldLayout();
+      FieldLayout(const int32_t * lows, const int32_t * highs, int32_t count);
+
+      bool addField(int32_t low, int32_t high);
+      int32_t size() const { return fieldCount; }
+      uint64_t mask() const { return layoutMask; }
+      bool usesBMI2() const { return bmi2; }
+
+      void extract(uint64_t word, uint64_t * fields) const;
+      uint64_t pack(const uint64_t * fields, uint64_t dest) const;
+
+      void extract(const uint64_t * words, size_t count, uint64_t * fields) const;
+      void pack(const uint64_t * fields, uint64_t * words, size_t count) const;
+};
+
+#endif
@@ -1,17 +1,152 @@
+#ifndef TOOLS_H
+#define TOOLS_H
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+
 #define LONGSIZE 8
 
-class Tools
+/*
+ * WordTools holds the bit and overflow functions for one word type T:
+ * uint8_t, uint16_t, uint32_t, uint64_t or unsigned __int128.  Bit
+ * numbers run from 0 (the low order bit) to WIDTH - 1 and byte numbers
+ * from 0 to BYTES - 1; the sign bit is bit WIDTH - 1.  The functions
+ * are defined in Tools.C and built there for those five types only.
+ */
+template <typename T>
+class WordTools
+{
+   public:
+      static const int32_t WIDTH = sizeof(T) * 8;
+      static const int32_t BYTES = sizeof(T);
+
+      static T buildWord(const uint8_t * bytes);
+      static T getByte(T ul, int32_t byteNum);
+      static T getBits(T source, int32_t low, int32_t high);
+      static T clearBits(T source, int32_t low, int32_t high);
+      static T setBits(T source, int32_t low, int32_t high);
+      static T setByte(T ul, int32_t byteNum);
+      static T copyBits(T source, T dest,
+                        int32_t srclow, int32_t dstlow, int32_t length);
+      static uint8_t sign(T op);
+      static bool addOverflow(T op1, T op2);
+      static bool subOverflow(T op1, T op2);
+      static bool addChecked(T op1, T op2, T & result);
+      static bool subChecked(T op1, T op2, T & result);
+
+      //batched versions that apply the scalar operation to count words
+      static void getBits(const T * source, T * result,
+                          size_t count, int32_t low, int32_t high);
+      static void clearBits(const T * source, T * result,
+                            size_t count, int32_t low, int32_t high);
+      static void setBits(const T * source, T * result,
+                          size_t count, int32_t low, int32_t high);
+      static void copyBits(const T * source, T * dest,
+                           size_t count, int32_t srclow, int32_t dstlow,
+                           int32_t length);
+      static bool addOverflow(const T * op1, const T * op2,
+                              T * result, uint64_t * overflow,
+                              size_t count);
+      static bool subOverflow(const T * op1, const T * op2,
+                              T * result, uint64_t * overflow,
+                              size_t count);
+
+      //copyBits with the bit positions fixed at compile time
+      template <int32_t srclow, int32_t dstlow, int32_t length>
+      static constexpr T copyBits(T source, T dest);
+};
+
+/*
+ * Tools is the 64-bit WordTools plus the functions that turn little
+ * endian bytes into 64-bit longs and back
+ */
+class Tools : public WordTools<uint64_t>
 {
    public:
+      static uint64_t loadLong(const uint8_t * bytes);
       static uint64_t buildLong(uint8_t bytes[LONGSIZE]);
-      static uint64_t getByte(uint64_t ul, int32_t byteNum);
-      static uint64_t getBits(uint64_t source, int32_t low, int32_t high);
-      static uint64_t clearBits(uint64_t source, int32_t low, int32_t high);
-      static uint64_t setBits(uint64_t source, int32_t low, int32_t high);
-      static uint64_t setByte(uint64_t ul, int32_t byteNum);
-      static uint64_t copyBits(uint64_t source, uint64_t dest,
-                               int32_t srclow, int32_t dstlow, int32_t length);
-      static uint8_t sign(uint64_t op);
-      static bool addOverflow(uint64_t op1, uint64_t op2);
-      static bool subOverflow(uint64_t op1, uint64_t op2);
+      static size_t buildLongs(const uint8_t * bytes, size_t length,
+                               uint64_t * words);
+      static void splitLongs(const uint64_t * words, size_t length,
+                             uint8_t * bytes);
+};
+
+/**
+ * loads the 8 bytes at an arbitrary (possibly unaligned) address as a
+ * little endian uint64_t.  memcpy compiles to a single load and the
+ * byte swap is only done on big endian hosts.
+ *
+ * @param const uint8_t * bytes that points to the first of 8 bytes
+ * @return the 8 bytes as a uint64_t, bytes[0] in the low order byte
+ */
+inline uint64_t Tools::loadLong(const uint8_t * bytes)
+{
+   uint64_t word;
+   memcpy(&word, bytes, LONGSIZE);
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+   word = __builtin_bswap64(word);
+#endif
+   return word;
+}
+
+typedef WordTools<uint8_t> Tools8;
+typedef WordTools<uint16_t> Tools16;
+typedef WordTools<uint32_t> Tools32;
+typedef WordTools<unsigned __int128> Tools128;
+
+/*
+ * BitField is the compile time counterpart of getBits, setBits and
+ * clearBits for fields whose bit positions are known when the code is
+ * written.  The range is checked by the compiler, so each operation is
+ * a single shift and/or mask with no branches.  The word type defaults
+ * to uint64_t; BitField<4, 11, uint16_t> works on 16-bit words.
+ *
+ * for example, BitField<4, 11>::get(0x8877665544332211) returns 0x21
+ *              BitField<0, 7>::set(0x1122334455667788) returns 0x11223344556677ff
+ *              BitField<0, 7>::clear(0x1122334455667788) returns 0x1122334455667700
+ */
+template <int32_t low, int32_t high, typename T = uint64_t>
+class BitField
+{
+   static_assert(low >= 0 && high < (int32_t) sizeof(T) * 8 && low <= high,
+                 "BitField requires 0 <= low <= high < bits in T");
+
+   public:
+      static constexpr int32_t width() { return high - low + 1; }
+      static constexpr T mask()
+      {
+         return (T) ((T) ((T) ~(T) 0 >> (sizeof(T) * 8 - 1 - (high - low))) << low);
+      }
+      static constexpr T get(T source)
+      {
+         return (T) ((source & mask()) >> low);
+      }
+      static constexpr T set(T source)
+      {
+         return source | mask();
+      }
+      static constexpr T clear(T source)
+      {
+         return source & (T) ~mask();
+      }
 };
+
+/*
+ * copies length bits of source starting at srclow into dest starting
+ * at dstlow; out of range positions are a compile error instead of
+ * returning dest unchanged
+ *
+ * for example, Tools::copyBits<0, 8, 8>(0x1122334455667788, 0x8877665544332211)
+ *              returns 0x8877665544338811
+ */
+template <typename T>
+template <int32_t srclow, int32_t dstlow, int32_t length>
+constexpr T WordTools<T>::copyBits(T source, T dest)
+{
+   static_assert(length > 0, "copyBits requires a positive length");
+   return BitField<dstlow, dstlow + length - 1, T>::clear(dest) |
+          (T) (BitField<srclow, srclow + length - 1, T>::get(source) << dstlow);
+}
+
+#endif
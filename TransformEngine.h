@@ -0,0 +1,121 @@
+#ifndef TRANSFORMENGINE_H
+#define TRANSFORMENGINE_H
+
+#include <cstdint>
+#include <cstddef>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/*
+ * TransformEngine runs a pipeline of batched Tools operations over a
+ * large array of uint64_t words on a pool of threads.  The array is cut
+ * into chunks small enough to stay in cache and every step of the
+ * pipeline is applied to a chunk before moving on to the next one, so
+ * a pipeline of several steps reads and writes memory once.
+ *
+ * Each thread starts on its own contiguous run of chunks and, when that
+ * runs out, steals chunks from the end of other threads' runs.  Every
+ * step writes only the words (and overflow bits) of the chunk it is
+ * given, so the results are the same no matter which thread ran which
+ * chunk or in what order.  allocate() has each thread touch the pages
+ * of its own run first.  An engine built with pin set (Linux only) also
+ * pins each thread to one CPU, with the threads spread evenly over the
+ * NUMA nodes, so those pages are placed on the node of the thread that
+ * works on them and run() reads and writes local memory except for
+ * stolen chunks.  Pinning always starts at the same CPUs, so it is
+ * meant for one engine that has the machine to itself; engines that
+ * share the machine should leave it off and let the scheduler place
+ * their threads.
+ *
+ * for example, to clear bits 8 through 15 and then add a second array
+ * with overflow checking:
+ *              TransformEngine engine;
+ *              engine.addClearBits(8, 15);
+ *              engine.addAddOverflow(other, flags);
+ *              engine.run(words, count);
+ */
+class TransformEngine
+{
+   public:
+      static const size_t DEFAULTCHUNKWORDS = 32768; //256 KB
+
+      explicit TransformEngine(int32_t threads = 0,
+                               size_t chunkWords = DEFAULTCHUNKWORDS,
+                               bool pin = false);
+      ~TransformEngine();
+      TransformEngine(const TransformEngine &) = delete;
+      TransformEngine & operator=(const TransformEngine &) = delete;
+
+      int32_t threadCount() const { return threads; }
+      size_t chunkSize() const { return chunkWords; }
+      bool isPinned() const { return pinned; }
+
+      uint64_t * allocate(size_t count);
+      static void release(uint64_t * words, size_t count);
+
+      bool addGetBits(int32_t low, int32_t high);
+      bool addSetBits(int32_t low, int32_t high);
+      bool addClearBits(int32_t low, int32_t high);
+      bool addSetByte(int32_t byteNum);
+      bool addCopyBits(const uint64_t * source, int32_t srclow,
+                       int32_t dstlow, int32_t length);
+      bool addAddOverflow(const uint64_t * op2, uint64_t * overflow);
+      bool addSubOverflow(const uint64_t * op2, uint64_t * overflow);
+      void clearSteps() { steps.clear(); }
+      size_t stepCount() const { return steps.size(); }
+
+      size_t run(uint64_t * words, size_t count);
+
+   private:
+      enum StepKind { GETBITS, SETBITS, CLEARBITS, COPYBITS, ADDOVERFLOW,
+                      SUBOVERFLOW };
+
+      struct Step
+      {
+         StepKind kind;
+         int32_t low;
+         int32_t high;
+         int32_t length;
+         const uint64_t * other;
+         uint64_t * overflow;
+      };
+
+      //the chunks a thread has left: it takes from the front and
+      //thieves take from the back, both under the queue's lock.  the
+      //padding keeps two threads' queues off the same cache line
+      struct ChunkQueue
+      {
+         std::mutex lock;
+         size_t front;
+         size_t back;
+         char padding[64];
+      };
+
+      int32_t threads;
+      size_t chunkWords;
+      bool pinned;
+      std::vector<Step> steps;
+
+      std::vector<std::thread> pool;
+      std::unique_ptr<ChunkQueue[]> queues;
+      std::mutex lock;
+      std::condition_variable start;
+      std::condition_variable done;
+      std::function<void(int32_t)> job;
+      uint64_t generation;
+      int32_t busy;
+      bool stopping;
+
+      void worker(int32_t id);
+      void parallel(const std::function<void(int32_t)> & work);
+      void plan(size_t chunks);
+      bool nextChunk(int32_t id, size_t & chunk);
+      size_t runChunk(uint64_t * words, size_t begin, size_t count) const;
+};
+
+#endif
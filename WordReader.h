@@ -0,0 +1,72 @@
+#ifndef WORDREADER_H
+#define WORDREADER_H
+
+#include <cstdint>
+#include <cstddef>
+#include "Tools.h"
+
+/*
+ * WordReader walks a little endian byte image 8 bytes at a time and
+ * hands back uint64_t words the way Tools::buildLong would build them.
+ * The image is either a caller owned buffer or a file that the reader
+ * maps into memory; in both cases no bytes are copied until a word is
+ * read.  The image does not need to be aligned or a multiple of 8 bytes
+ * long; the missing high order bytes of a partial last word are 0.
+ */
+class WordReader
+{
+   private:
+      const uint8_t * bytes;
+      size_t length;
+      size_t offset;
+      void * mapping;
+      size_t mappingLength;
+      void unmap();
+
+   public:
+      WordReader();
+      WordReader(const uint8_t * bytes, size_t length);
+      ~WordReader();
+      WordReader(const WordReader &) = delete;
+      WordReader & operator=(const WordReader &) = delete;
+
+      bool map(const char * path);
+      void reset(const uint8_t * bytes, size_t length);
+      void seek(size_t offset);
+
+      const uint8_t * data() const { return bytes; }
+      size_t size() const { return length; }
+      size_t position() const { return offset; }
+      size_t remaining() const { return length - offset; }
+
+      uint64_t wordAt(size_t offset) const;
+      bool next(uint64_t & word);
+      size_t read(uint64_t * words, size_t count);
+};
+
+/**
+ * reads the next word and advances the read position by 8 bytes (or
+ * to the end of the image for a partial last word)
+ *
+ * @param uint64_t & word that receives the word
+ * @return false if there are no bytes left to read
+ */
+inline bool WordReader::next(uint64_t & word)
+{
+   //a whole word is loaded here so the loop calling next can keep
+   //offset in a register; only the partial last word goes to wordAt
+   if (length - offset >= LONGSIZE) {
+      word = Tools::loadLong(bytes + offset);
+      offset += LONGSIZE;
+      return true;
+   }
+   if (offset >= length) {
+      return false;
+   }
+
+   word = wordAt(offset);
+   offset = length;
+   return true;
+}
+
+#endif